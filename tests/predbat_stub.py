@@ -0,0 +1,168 @@
+"""
+Load predbat.py outside of AppDaemon for the tests
+
+AppDaemon (and pytz/requests when they are not installed) are replaced with minimal stand-ins,
+the PredBat object is created without AppDaemon's constructor and logs into a list.
+"""
+import copy
+import math
+import os
+import random
+import sys
+import types
+from datetime import datetime, timezone
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'apps', 'predbat'))
+
+def stub_module(name, **attributes):
+    module = types.ModuleType(name)
+    for key, value in attributes.items():
+        setattr(module, key, value)
+    sys.modules[name] = module
+    return module
+
+try:
+    import appdaemon.plugins.hass.hassapi
+except ImportError:
+    class Hass():
+        pass
+    stub_module('appdaemon')
+    stub_module('appdaemon.plugins')
+    stub_module('appdaemon.plugins.hass')
+    stub_module('appdaemon.plugins.hass.hassapi', Hass=Hass)
+
+try:
+    import pytz
+except ImportError:
+    stub_module('pytz', utc=timezone.utc, timezone=lambda name: timezone.utc)
+
+try:
+    import requests
+except ImportError:
+    stub_module('requests')
+
+import predbat
+
+def make_predbat(args=None):
+    """
+    A PredBat with reset() defaults, no HA connection and the log kept in base.logs
+    """
+    base = predbat.PredBat.__new__(predbat.PredBat)
+    base.args = args if args else {}
+    base.logs = []
+    base.log = lambda message: base.logs.append(message)
+    base.set_state = lambda entity_id, state=None, attributes=None: None
+    base.reset()
+    return base
+
+def make_scenario(agile=False):
+    """
+    A PredBat set up to plan two days ahead from 12:05 with a 9.5kWh battery, a synthetic load with an evening peak,
+    a clear sky PV curve and either a two rate (7.5p/30p) or half hourly import tariff
+    Returns the PredBat with its low and high rate windows, the PV forecast and the 10% PV forecast
+    """
+    base = make_predbat()
+    base.forecast_minutes = 48*60
+    base.forecast_days = 2
+    base.forecast_plan_hours = 24
+    base.minutes_now = 12*60 + 5
+    base.midnight_utc = datetime(2023, 7, 1, tzinfo=timezone.utc)
+    base.midnight = datetime(2023, 7, 1)
+    base.soc_max = 9.5
+    base.soc_kw = 5.0
+    base.reserve = 0.38
+    base.battery_rate_max = 2.6/60
+    base.charge_rate_max = 2.6/60
+    base.discharge_rate_max = 2.6/60
+    base.inverter_limit = 3.6/60
+    base.battery_loss = 0.95
+    base.battery_loss_discharge = 0.95
+    base.inverter_loss = 0.96
+    base.inverter_hybrid = True
+    base.metric_house = 38.0
+    base.metric_battery = 7.5
+    base.metric_export = 4.0
+    base.days_previous = [1]
+    base.max_days_previous = 2
+    base.metric_min_improvement = 0.0
+    base.metric_min_improvement_discharge = 0.1
+    base.pv_metric10_weight = 0.15
+    base.best_soc_step = 0.25
+    base.best_soc_min = 0
+    base.best_soc_keep = 1.0
+    base.best_soc_margin = 0
+    base.best_soc_pass_margin = 0
+    base.car_charging_hold = False
+    base.iboost_enable = False
+    base.iboost_today = 0
+    base.iboost_max_energy = 3.0
+    base.iboost_max_power = 2.4/60
+    base.iboost_min_power = 0.5/60
+    base.iboost_min_soc = 50
+    base.cost_today_sofar = 0
+    base.current_charge_limit = 100.0
+    base.calculate_best_charge = True
+    base.calculate_best_discharge = True
+    base.calculate_charge_all = True
+    base.calculate_discharge_all = False
+    base.calculate_charge_passes = 1
+    base.calculate_discharge_passes = 1
+    base.calculate_charge_oldest = False
+    base.calculate_discharge_oldest = True
+    base.combine_mixed_rates = False
+    base.combine_charge_slots = not agile
+    base.combine_discharge_slots = False
+    base.charge_slot_split = 30
+    base.discharge_slot_split = 30
+    base.rate_low_match_export = False
+    base.rate_low_threshold = 0.8
+    base.rate_high_threshold = 1.2
+    base.max_windows = 128
+
+    # Load is an incrementing sensor going back in time, 0.4kW with an evening peak
+    total = 0
+    load = {}
+    for minute in range(0, 3*24*60):
+        total += 0.4/60 * (1.5 if (minute // 60) % 24 in (17, 18, 19) else 1.0)
+        load[minute] = total
+    base.load_minutes = {minute : total - load[minute] for minute in load}
+
+    pv_forecast_minute = {}
+    pv_forecast_minute10 = {}
+    rate_import = {}
+    rate_export = {}
+    for minute in range(0, 5*24*60):
+        hour = (minute % (24*60)) / 60.0
+        if minute < 4*24*60:
+            pv_forecast_minute[minute] = max(0, math.sin((hour - 5) / 14 * math.pi)) * 4.0/60 if 5 < hour < 19 else 0
+            pv_forecast_minute10[minute] = pv_forecast_minute[minute] * 0.5
+        if agile:
+            half_hour = ((minute % (24*60)) // 30) / 2.0
+            rate_import[minute] = round(15 + 10*math.sin(half_hour / 24 * 2 * math.pi) + (20 if 16 <= half_hour < 19 else 0) + ((minute // 30) % 5), 2)
+            rate_export[minute] = round(rate_import[minute] * 0.6, 2)
+        else:
+            rate_import[minute] = 7.5 if (hour < 4.5 or hour >= 23.5) else 30.0
+            rate_export[minute] = 15.0
+
+    base.rate_import = base.rate_scan(rate_import, [])
+    base.rate_export = base.rate_scan_export(rate_export)
+    base.set_rate_thresholds()
+    base.high_export_rates = base.rate_scan_window(base.rate_export, 5, base.rate_export_threshold, True)
+    base.low_rates = base.rate_scan_window(base.rate_import, 5, base.rate_threshold, False)
+    base.charge_window_best = copy.deepcopy(base.low_rates)
+    base.discharge_window_best = copy.deepcopy(base.high_export_rates)
+    base.charge_limit_best = [base.soc_max for window in base.charge_window_best]
+    base.discharge_limits_best = [100.0 for window in base.discharge_window_best]
+    return base, pv_forecast_minute, pv_forecast_minute10
+
+def random_plans(base, count, seed=1):
+    """
+    Random charge and discharge limits for the windows of a scenario, about two thirds of the discharge windows are enabled
+    """
+    rand = random.Random(seed)
+    charge_limits = []
+    discharge_limits_set = []
+    for n in range(0, count):
+        charge_limits.append([rand.choice([0, base.reserve, 2.0, base.soc_max / 2, 7.0, base.soc_max]) for window in base.charge_window_best])
+        discharge_limits_set.append([rand.choice([100.0, 100.0, 4.0, 20.0, 50.0, 75.0]) for window in base.discharge_window_best])
+    return charge_limits, discharge_limits_set
@@ -0,0 +1,72 @@
+"""
+The archive must read back what each cycle wrote, to float32 precision, and archive_query must return only the cycles asked for
+"""
+import os
+import shutil
+import tempfile
+import unittest
+from datetime import datetime, timedelta, timezone
+
+from predbat_stub import make_scenario
+
+class TestArchive(unittest.TestCase):
+    def setUp(self):
+        self.tmpdir = tempfile.mkdtemp()
+        self.base, pv_forecast_minute, pv_forecast_minute10 = make_scenario(agile=True)
+        self.base.args['archive_dir'] = self.tmpdir
+        base = self.base
+        end_record = base.record_length(base.charge_window_best)
+        base.run_prediction(base.charge_limit_best, base.charge_window_best, base.discharge_window_best, base.discharge_limits_best, base.load_minutes, pv_forecast_minute, save='best', end_record=end_record)
+
+        # Four cycles an hour apart either side of midnight
+        self.cycles = [datetime(2023, 7, 1, 22, 0, tzinfo=timezone.utc) + timedelta(hours=hour) for hour in range(0, 4)]
+        for cycle in self.cycles:
+            base.soc_kw = cycle.hour / 4.0
+            base.archive_cycle(cycle)
+
+    def tearDown(self):
+        shutil.rmtree(self.tmpdir)
+
+    def test_read(self):
+        base = self.base
+        day = self.cycles[0].date()
+        plan = base.archive_read(day, 'plan')
+        steps = len(base.predict_archive['soc'])
+        self.assertEqual(len(plan['cycle']), 2 * steps)
+        self.assertEqual(list(plan['cycle'][:steps]), [self.cycles[0].timestamp()] * steps)
+        time_start = (base.midnight_utc + timedelta(minutes=base.minutes_now)).timestamp()
+        self.assertEqual(list(plan['time'][:steps]), [time_start + step_n * 5 * 60 for step_n in range(0, steps)])
+        for column in ['soc', 'cost', 'import', 'export', 'load', 'pv', 'charge_limit', 'discharge_limit']:
+            for step_n in range(0, steps):
+                self.assertAlmostEqual(plan[column][step_n], base.predict_archive[column][step_n], delta=abs(base.predict_archive[column][step_n]) * 1e-6 + 1e-6)
+
+        # A cycle is about 7KB rather than 46KB with float64 columns and the cycle and time stored per row
+        self.assertLess(os.path.getsize(base.archive_file(day)) / 2, 10 * 1024)
+
+        actual = base.archive_read(day, 'actual', ['cycle', 'soc'])
+        self.assertEqual(list(actual['cycle']), [cycle.timestamp() for cycle in self.cycles[0:2]])
+        self.assertEqual(list(actual['soc']), [22 / 4.0, 23 / 4.0])
+
+    def test_query(self):
+        base = self.base
+        # From the second cycle up to (not including) the last, across midnight
+        actual = base.archive_query(self.cycles[1], self.cycles[3], 'actual')
+        self.assertEqual(list(actual['cycle']), [self.cycles[1].timestamp(), self.cycles[2].timestamp()])
+        self.assertEqual(list(actual['soc']), [23 / 4.0, 0.0])
+        plan = base.archive_query(self.cycles[1], self.cycles[3], 'plan', ['cycle', 'soc'])
+        self.assertEqual(sorted(set(plan['cycle'])), [self.cycles[1].timestamp(), self.cycles[2].timestamp()])
+        self.assertEqual(len(plan['soc']), 2 * len(base.predict_archive['soc']))
+        self.assertEqual(base.archive_query(self.cycles[3] + timedelta(minutes=1), self.cycles[3] + timedelta(hours=1), 'actual')['cycle'].tolist(), [])
+
+    def test_partial_chunk(self):
+        # A chunk cut short by a crash is ignored and the chunks before it are still read
+        base = self.base
+        filename = base.archive_file(self.cycles[0].date())
+        size = os.path.getsize(filename)
+        with open(filename, 'r+b') as handle:
+            handle.truncate(size - 10)
+        actual = base.archive_read(self.cycles[0].date(), 'actual')
+        self.assertEqual(list(actual['cycle']), [self.cycles[0].timestamp()])
+
+if __name__ == '__main__':
+    unittest.main()
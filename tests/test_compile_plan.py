@@ -0,0 +1,59 @@
+"""
+compile_plan must resolve a plan the same way as remove_intersecting_windows and record_length
+"""
+import unittest
+
+from predbat_stub import make_predbat
+
+def windows(times):
+    return [{'start' : start, 'end' : end} for start, end in times]
+
+class TestCompilePlan(unittest.TestCase):
+    def setUp(self):
+        self.base = make_predbat()
+        self.base.minutes_now = 12*60 + 5
+        self.base.forecast_minutes = 48*60
+        self.base.forecast_plan_hours = 24
+        self.base.soc_max = 9.5
+
+    def check(self, charge_limit, charge_window, discharge_window, discharge_limits, end_record=None):
+        base = self.base
+        plan = base.compile_plan(charge_limit, charge_window, discharge_window, discharge_limits, end_record=end_record)
+        expect_limit, expect_window = base.remove_intersecting_windows(charge_limit, charge_window, discharge_limits, discharge_window)
+        self.assertEqual(plan['charge_limit'], expect_limit)
+        self.assertEqual(plan['charge_window'], expect_window)
+        self.assertEqual(plan['end_record'], end_record if end_record else base.record_length(expect_window))
+        self.assertEqual(plan['discharge_soc'], [base.soc_max * limit / 100.0 for limit in discharge_limits])
+        for step_n in range(0, len(plan['charge_window_n'])):
+            minute_absolute = base.minutes_now + step_n * 5
+            self.assertEqual(plan['charge_window_n'][step_n], base.in_charge_window(expect_window, minute_absolute))
+            self.assertEqual(plan['discharge_window_n'][step_n], base.in_charge_window(discharge_window, minute_absolute))
+
+    def test_overlapping(self):
+        # Discharges cutting the end, the start and the whole of charge windows
+        charge_window = windows([(23*60, 29*60), (35*60, 37*60), (47*60, 53*60)])
+        discharge_window = windows([(28*60, 30*60), (34*60, 36*60), (46*60, 54*60)])
+        for discharge_limits in [[100.0, 100.0, 100.0], [4.0, 100.0, 100.0], [4.0, 50.0, 100.0], [4.0, 50.0, 20.0]]:
+            for charge_limit in [[9.5, 9.5, 9.5], [0.5, 4.0, 9.5]]:
+                self.check(charge_limit, charge_window, discharge_window, discharge_limits)
+
+    def test_adjacent(self):
+        # Discharge windows that start where a charge window ends or end where one starts
+        charge_window = windows([(14*60, 15*60), (16*60, 17*60), (23*60, 24*60 + 30)])
+        discharge_window = windows([(15*60, 16*60), (17*60, 19*60), (24*60 + 30, 25*60)])
+        for discharge_limits in [[100.0, 100.0, 100.0], [0.0, 0.0, 0.0], [100.0, 30.0, 0.0]]:
+            self.check([2.0, 5.0, 9.5], charge_window, discharge_window, discharge_limits)
+            self.check([2.0, 5.0, 9.5], charge_window, discharge_window, discharge_limits, end_record=18*60)
+
+    def test_all_n(self):
+        # The first n windows set to one limit as the all windows pass does, sharing the cached layout
+        charge_window = windows([(start, start + 30) for start in range(13*60, 40*60, 60)])
+        discharge_window = windows([(start + 30, start + 60) for start in range(13*60, 40*60, 120)])
+        discharge_limits = [100.0 if n % 3 else 10.0 for n in range(0, len(discharge_window))]
+        for all_n in range(1, len(charge_window) + 1):
+            for limit in [0.0, 4.75, 9.5]:
+                charge_limit = [limit if n < all_n else self.base.soc_max for n in range(0, len(charge_window))]
+                self.check(charge_limit, charge_window, discharge_window, discharge_limits)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,60 @@
+"""
+The control loop must read the SOC again on every check, so a force discharge stops as soon as the SOC reaches its target
+"""
+import unittest
+from datetime import datetime
+from unittest import mock
+
+import predbat
+from predbat_stub import make_predbat
+
+class Response():
+    def __init__(self, soc_kwh):
+        self.status_code = 200
+        self.soc_kwh = soc_kwh
+
+    def json(self):
+        return {'Invertor_Details' : {'Battery_Capacity_kWh' : 9.5, 'Invertor_Max_Rate' : 2600},
+                'Control' : {'Battery_Power_Reserve' : 4, 'Enable_Charge_Schedule' : 'disable', 'Enable_Discharge_Schedule' : 'disable'},
+                'Power' : {'Power' : {'SOC_kWh' : self.soc_kwh}}}
+
+class TestControlLoop(unittest.TestCase):
+    def test_soc_between_checks(self):
+        base = make_predbat({'givtcp_rest' : ['http://givtcp:6345']})
+        base.record_status = lambda message, debug="", had_errors=False: None
+        base.forecast_minutes = 48*60
+        base.battery_scaling = 1.0
+        base.battery_rate_max_scaling = 1.0
+        base.set_reserve_enable = False
+        socs = [8.0, 7.0, 4.76]
+        with mock.patch.object(predbat.requests, 'get', create=True, side_effect=lambda url: Response(socs.pop(0))) as get:
+            inverter = predbat.Inverter(base)
+            base.inverters = [inverter]
+            stops = []
+            inverter.adjust_force_discharge = lambda enable, start=None, end=None: stops.append(enable)
+
+            # Force discharging to 50% (4.75kWh) in a window active now
+            base.midnight = datetime.now().replace(hour=0, minute=0, second=0, microsecond=0)
+            minutes_now = int((datetime.now() - base.midnight).total_seconds() / 60)
+            base.soc_max = 9.5
+            base.set_discharge_window = True
+            base.set_charge_window = False
+            base.discharge_window_best = [{'start' : minutes_now - 10, 'end' : minutes_now + 60}]
+            base.discharge_limits_best = [50.0]
+            base.control_every = 30
+            base.control_status = "Discharging"
+
+            base.control_loop()
+            self.assertEqual(base.soc_kw, 7.0)
+            self.assertEqual(base.control_status, "Discharging")
+            self.assertEqual(stops, [])
+
+            # The SOC has fallen to within one check of the target
+            base.control_loop()
+            self.assertEqual(base.soc_kw, 4.76)
+            self.assertEqual(base.control_status, "Hold discharging")
+            self.assertEqual(stops, [False])
+            self.assertEqual(get.call_count, 3)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,32 @@
+"""
+With run_every_adaptive a plan that fails must not be retried on every 15 second check
+"""
+import unittest
+from datetime import datetime, timedelta
+
+from predbat_stub import make_predbat
+
+class TestPlanCadence(unittest.TestCase):
+    def test_failed_plan_backs_off(self):
+        base = make_predbat({'run_every' : 5})
+        base.plan_adaptive = True
+        base.plan_next_time = datetime.now() - timedelta(seconds=1)
+        runs = []
+        def update_pred(scheduled):
+            runs.append(scheduled)
+            raise ValueError("plan failed")
+        base.update_pred = update_pred
+
+        with self.assertRaises(ValueError):
+            base.update_time_loop(None)
+        self.assertEqual(runs, [True])
+        self.assertFalse(base.prediction_started)
+        self.assertGreater(base.plan_next_time, datetime.now() + timedelta(minutes=4))
+
+        # The next check is not due yet
+        base.update_pending = False
+        base.update_time_loop(None)
+        self.assertEqual(runs, [True])
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,27 @@
+"""
+run_prediction_batch must give exactly the same results as scoring each candidate with run_prediction
+"""
+import unittest
+
+from predbat_stub import make_scenario, random_plans
+
+class TestPredictionBatch(unittest.TestCase):
+    def check(self, agile):
+        base, pv_forecast_minute, pv_forecast_minute10 = make_scenario(agile=agile)
+        end_record = base.record_length(base.charge_window_best)
+        charge_limits, discharge_limits_set = random_plans(base, 40)
+        for pv in [pv_forecast_minute, pv_forecast_minute10]:
+            results = base.run_prediction_batch(charge_limits, base.charge_window_best, base.discharge_window_best, discharge_limits_set, base.load_minutes, pv, end_record=end_record)
+            self.assertEqual(len(results), len(charge_limits))
+            for n in range(0, len(charge_limits)):
+                expect = base.run_prediction(charge_limits[n], base.charge_window_best, base.discharge_window_best, discharge_limits_set[n], base.load_minutes, pv, end_record=end_record, trial=True)
+                self.assertEqual(results[n], expect)
+
+    def test_two_rate(self):
+        self.check(agile=False)
+
+    def test_half_hourly(self):
+        self.check(agile=True)
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,51 @@
+"""
+run_prediction_fixed must not depend on how candidates are batched, must stay within 1p of the floating point simulation
+and with calculate_fixed the final plan must be scored the same way as the candidates
+"""
+import random
+import unittest
+
+from predbat_stub import make_scenario, random_plans
+
+class TestPredictionFixed(unittest.TestCase):
+    def setUp(self):
+        self.base, self.pv_forecast_minute, self.pv_forecast_minute10 = make_scenario(agile=True)
+        self.end_record = self.base.record_length(self.base.charge_window_best)
+        self.charge_limits, self.discharge_limits_set = random_plans(self.base, 40)
+
+    def run_fixed(self, charge_limits, discharge_limits_set):
+        base = self.base
+        return base.run_prediction_fixed(charge_limits, base.charge_window_best, base.discharge_window_best, discharge_limits_set, base.load_minutes, self.pv_forecast_minute, end_record=self.end_record)
+
+    def test_batch_order(self):
+        results = self.run_fixed(self.charge_limits, self.discharge_limits_set)
+        order = list(range(0, len(self.charge_limits)))
+        random.Random(2).shuffle(order)
+        shuffled = self.run_fixed([self.charge_limits[n] for n in order], [self.discharge_limits_set[n] for n in order])
+        for position in range(0, len(order)):
+            self.assertEqual(shuffled[position], results[order[position]])
+        for n in range(0, len(self.charge_limits), 7):
+            self.assertEqual(self.run_fixed([self.charge_limits[n]], [self.discharge_limits_set[n]])[0], results[n])
+
+    def test_matches_float(self):
+        base = self.base
+        results = self.run_fixed(self.charge_limits, self.discharge_limits_set)
+        for n in range(0, len(self.charge_limits)):
+            expect = base.run_prediction(self.charge_limits[n], base.charge_window_best, base.discharge_window_best, self.discharge_limits_set[n], base.load_minutes, self.pv_forecast_minute, end_record=self.end_record, trial=True)
+            self.assertEqual(results[n][1], expect[1])
+            self.assertLess(abs(results[n][0] - expect[0]), 1.0)
+            self.assertLess(abs(results[n][6] - expect[6]), 0.05)
+
+    def test_final_plan(self):
+        base = self.base
+        base.calculate_fixed = True
+        for n in range(0, 3):
+            result = base.run_prediction_final(self.charge_limits[n], base.charge_window_best, base.discharge_window_best, self.discharge_limits_set[n], base.load_minutes, self.pv_forecast_minute, end_record=self.end_record)
+            candidate = base.run_prediction_candidates([self.charge_limits[n]], base.charge_window_best, base.discharge_window_best, [self.discharge_limits_set[n]], base.load_minutes, self.pv_forecast_minute, end_record=self.end_record)[0]
+            self.assertEqual(candidate, self.run_fixed([self.charge_limits[n]], [self.discharge_limits_set[n]])[0])
+            # metric, charge limit percent, soc min, final soc and the minute of the minimum soc
+            for index in [0, 1, 5, 6, 7]:
+                self.assertEqual(result[index], candidate[index])
+
+if __name__ == '__main__':
+    unittest.main()
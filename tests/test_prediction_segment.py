@@ -0,0 +1,33 @@
+"""
+run_prediction_segment must match run_prediction to within 1e-9 (pence and kWh)
+"""
+import unittest
+
+from predbat_stub import make_scenario, random_plans
+
+TOLERANCE = 1e-9
+
+class TestPredictionSegment(unittest.TestCase):
+    def check(self, agile):
+        base, pv_forecast_minute, pv_forecast_minute10 = make_scenario(agile=agile)
+        end_record = base.record_length(base.charge_window_best)
+        charge_limits, discharge_limits_set = random_plans(base, 40, seed=4)
+        for pv in [pv_forecast_minute, pv_forecast_minute10]:
+            for n in range(0, len(charge_limits)):
+                result = base.run_prediction_segment(charge_limits[n], base.charge_window_best, base.discharge_window_best, discharge_limits_set[n], base.load_minutes, pv, end_record=end_record)
+                expect = base.run_prediction(charge_limits[n], base.charge_window_best, base.discharge_window_best, discharge_limits_set[n], base.load_minutes, pv, end_record=end_record, trial=True)
+                # metric, import battery, import house, export, soc min and final soc
+                for index in [0, 2, 3, 4, 5, 6]:
+                    self.assertLessEqual(abs(result[index] - expect[index]), TOLERANCE)
+                # charge limit percent and the minute of the minimum soc
+                self.assertEqual(result[1], expect[1])
+                self.assertEqual(result[7], expect[7])
+
+    def test_two_rate(self):
+        self.check(agile=False)
+
+    def test_half_hourly(self):
+        self.check(agile=True)
+
+if __name__ == '__main__':
+    unittest.main()
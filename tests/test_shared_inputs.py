@@ -0,0 +1,69 @@
+"""
+Octopus rates shared between instances must be downloaded once but parsed with each instance's own midnight,
+and a shared input must be freed only when the last instance holding it terminates
+"""
+import unittest
+from datetime import datetime, timezone
+from unittest import mock
+
+import predbat
+from predbat_stub import make_predbat
+
+URL = "https://api.octopus.energy/v1/products/TEST/electricity-tariffs/TEST/standard-unit-rates/"
+
+class Response():
+    def __init__(self, data):
+        self.data = data
+
+    def json(self):
+        return self.data
+
+def rates():
+    # Half hourly rates for three days from 2023-07-01, 10p on the first day, 20p on the second and 30p on the third
+    results = []
+    for slot in range(0, 3*48):
+        start = datetime(2023, 7, 1, tzinfo=timezone.utc).timestamp() + slot * 30 * 60
+        results.append({'value_inc_vat' : 10.0 * (1 + slot // 48),
+                        'valid_from' : datetime.fromtimestamp(start, timezone.utc).strftime("%Y-%m-%dT%H:%M:%SZ"),
+                        'valid_to' : datetime.fromtimestamp(start + 30 * 60, timezone.utc).strftime("%Y-%m-%dT%H:%M:%SZ")})
+    return {'results' : results, 'next' : None}
+
+def make_instance(midnight_utc, forecast_days):
+    base = make_predbat()
+    base.midnight_utc = midnight_utc
+    base.forecast_days = forecast_days
+    base.octopus_url_cache = {}
+    return base
+
+class TestSharedInputs(unittest.TestCase):
+    def setUp(self):
+        predbat.SHARED_INPUTS.clear()
+
+    def test_parsed_per_instance(self):
+        first = make_instance(datetime(2023, 7, 1, tzinfo=timezone.utc), 1)
+        second = make_instance(datetime(2023, 7, 2, tzinfo=timezone.utc), 0)
+        with mock.patch.object(predbat.requests, 'get', create=True, return_value=Response(rates())) as get:
+            first_rates = first.download_octopus_rates(URL)
+            second_rates = second.download_octopus_rates(URL)
+            self.assertEqual(get.call_count, 1)
+        self.assertEqual(first_rates[0], 10.0)
+        self.assertEqual(first_rates[24*60], 20.0)
+        self.assertEqual(second_rates[0], 20.0)
+        self.assertEqual(second_rates[24*60], 30.0)
+        self.assertTrue(any("Using shared octopus data" in message for message in second.logs))
+
+    def test_release(self):
+        first = make_instance(datetime(2023, 7, 1, tzinfo=timezone.utc), 1)
+        second = make_instance(datetime(2023, 7, 1, tzinfo=timezone.utc), 1)
+        # Instances with the same prefix are still separate holders
+        second.prefix = first.prefix
+        with mock.patch.object(predbat.requests, 'get', create=True, return_value=Response(rates())):
+            first.download_octopus_rates(URL)
+            second.download_octopus_rates(URL)
+        first.shared_input_release()
+        self.assertIn(('octopus', URL), predbat.SHARED_INPUTS)
+        second.shared_input_release()
+        self.assertNotIn(('octopus', URL), predbat.SHARED_INPUTS)
+
+if __name__ == '__main__':
+    unittest.main()
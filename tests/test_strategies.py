@@ -0,0 +1,36 @@
+"""
+Optimiser strategies must return their plan without changing the best plan, so they can be run and compared on the same inputs
+"""
+import unittest
+
+from predbat_stub import make_scenario
+
+class TestStrategies(unittest.TestCase):
+    def setUp(self):
+        self.base, self.pv_forecast_minute, self.pv_forecast_minute10 = make_scenario(agile=True)
+        self.base.calculate_discharge_first = True
+        self.end_record = self.base.record_length(self.base.charge_window_best)
+
+    def run_strategy(self, strategy, plan):
+        base = self.base
+        return base.run_strategy(strategy, plan, self.end_record, base.load_minutes, self.pv_forecast_minute, self.pv_forecast_minute10)
+
+    def test_plan_returned(self):
+        base = self.base
+        start = base.plan_best()
+        results = {}
+        for strategy in base.optimiser_strategies():
+            results[strategy] = self.run_strategy(strategy, start)
+            self.assertEqual(base.plan_best(), start)
+            plan = results[strategy]['plan']
+            self.assertEqual(len(plan['charge_limit']), len(plan['charge_window']))
+            self.assertEqual(len(plan['discharge_limits']), len(plan['discharge_window']))
+            self.assertEqual(results[strategy]['metric'], base.dp2(base.plan_metric(plan, base.load_minutes, self.pv_forecast_minute, self.end_record)))
+        self.assertLessEqual(results['Sweep']['metric'], results['Greedy']['metric'])
+
+        # The order they are run in makes no difference
+        for strategy in reversed(list(base.optimiser_strategies().keys())):
+            self.assertEqual(self.run_strategy(strategy, start)['plan'], results[strategy]['plan'])
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,35 @@
+"""
+sort_window_by_gain must only drop windows that can't change the cost by min_improvement, whatever they cost in the current plan
+"""
+import unittest
+
+from predbat_stub import make_scenario
+
+class TestWindowGain(unittest.TestCase):
+    def test_unused_windows_kept(self):
+        base, pv_forecast_minute, pv_forecast_minute10 = make_scenario(agile=True)
+        window_ids = list(range(0, len(base.discharge_window_best)))
+        # Nothing attributed to any window, as for discharge windows that are all off in the current plan
+        selected = base.sort_window_by_gain('discharge', base.discharge_window_best, window_ids, {}, 0.1)
+        self.assertEqual(sorted(selected), window_ids)
+
+    def test_order(self):
+        base, pv_forecast_minute, pv_forecast_minute10 = make_scenario(agile=True)
+        window_ids = list(range(0, len(base.charge_window_best)))
+        attribution = {('charge', 3) : {'import_cost' : 20.0}, ('charge', 1) : {'import_cost' : 5.0, 'export_revenue' : -10.0}}
+        selected = base.sort_window_by_gain('charge', base.charge_window_best, window_ids, attribution, 0.1)
+        self.assertEqual(selected[:2], [3, 1])
+        self.assertEqual(sorted(selected), window_ids)
+
+    def test_no_spread_dropped(self):
+        base, pv_forecast_minute, pv_forecast_minute10 = make_scenario(agile=True)
+        for minute in base.rate_import:
+            base.rate_import[minute] = 15.0
+            base.rate_export[minute] = 15.0
+        base.rate_min = 15.0
+        window_ids = list(range(0, len(base.charge_window_best)))
+        attribution = {('charge', 0) : {'import_cost' : 20.0}}
+        self.assertEqual(base.sort_window_by_gain('charge', base.charge_window_best, window_ids, attribution, 0.1), [])
+
+if __name__ == '__main__':
+    unittest.main()